@@ -0,0 +1,91 @@
+/* File Name: TFMPSweep_check.ino
+ * Developer: Bud Ryerson
+ * Inception: 18OCT2026
+ * Last work: 18OCT2026
+
+ * Description: Arduino sketch to check the angle interpolation of
+ * the TFMPSweep class in the TFMPlus Library.  No device is needed.
+
+ * The sketch plays back a made up turret and sensor.  The turret
+ * turns at 5 revolutions per second and reports its angle every
+ * 200us.  The sensor sends a frame every millisecond (1000Hz).
+ * Each frame is passed in about a millisecond after it began,
+ * stamped with the time it began, as 'update()' would do.  So by
+ * then several newer angle events have already been passed in.
+
+ * Each point in the finished scan should sit at the angle the
+ * turret had when its frame began.  The largest error is printed
+ * in hundredths of a degree, followed by PASS or FAIL.
+ */
+
+#include <TFMPSweep.h>  // Include TFMPSweep from the TFMPlus Library v1.6.0
+TFMPSweep sweep;        // Create a sweep assembler object
+
+#include "printf.h"   // Modified to support Intel based Arduino
+                      // devices such as the Galileo. Download from:
+                      // https://github.com/spaniakos/AES/blob/master/printf.h
+
+#define SCAN_SIZE     250      // A little more than one revolution
+TFMPScanPoint scanA[ SCAN_SIZE], scanB[ SCAN_SIZE];
+
+#define REV_TIME      200000UL // microseconds per revolution
+#define EVENT_TIME    200UL    // microseconds between angle events
+#define FRAME_TIME    1000UL   // microseconds between frames
+#define FRAME_LAG     1100UL   // microseconds from frame start to pass in
+#define MAX_ERROR     10       // hundredths of a degree
+
+// Turret angle in hundredths of a degree at a given time.
+uint16_t turretAngle( uint32_t t)
+{
+    return ( uint16_t)( ( uint64_t)( t % REV_TIME) * TFMP_SWEEP_FULL / REV_TIME);
+}
+
+void setup()
+{
+    Serial.begin( 115200);   // Intialize terminal serial port
+    delay(20);               // Give port time to initalize
+    printf_begin();          // Initialize printf.
+    printf("\r\nTFMPSweep Interpolation Check - 18OCT2026\r\n");  // say 'hello'
+
+    sweep.begin( scanA, scanB, SCAN_SIZE, FRAME_1000);
+
+    // Play back one and a half revolutions a microsecond at a time.
+    // Each frame's 'dist' is its frame number, so that the time its
+    // frame began, and so its true angle, can be found again later.
+    uint32_t nextFrame = 0;
+    for( uint32_t t = 0; t < REV_TIME * 3 / 2; t++)
+    {
+        if( t % EVENT_TIME == 0) sweep.addAngle( turretAngle( t), t);
+        if( t == nextFrame + FRAME_LAG)
+        {
+            sweep.addSample( nextFrame / FRAME_TIME, 100, nextFrame);
+            nextFrame += FRAME_TIME;
+        }
+    }
+
+    TFMPScanPoint *scan;
+    uint16_t count;
+    if( !sweep.getScan( scan, count))
+    {
+        printf( "No scan finished.  FAIL\r\n");
+        return;
+    }
+
+    // Compare each point with the true angle, the short way round.
+    int32_t maxError = 0;
+    for( uint16_t i = 0; i < count; i++)
+    {
+        int32_t error = ( int32_t)scan[ i].angle -
+                        ( int32_t)turretAngle( scan[ i].dist * FRAME_TIME);
+        if( error < 0) error = -error;
+        if( error > TFMP_SWEEP_HALF) error = TFMP_SWEEP_FULL - error;
+        if( error > maxError) maxError = error;
+    }
+    printf( "Points: %u  Dropped: %lu  ", count, ( unsigned long)sweep.dropped);
+    printf( "Largest error: %li/100 degree  ", ( long)maxError);
+    printf( maxError <= MAX_ERROR ? "PASS\r\n" : "FAIL\r\n");
+}
+
+void loop()
+{
+}
@@ -0,0 +1,128 @@
+/* File Name: TFMPSweep_example.ino
+ * Developer: Bud Ryerson
+ * Inception: 18OCT2026
+ * Last work: 18OCT2026
+
+ * Description: Arduino sketch to build 2D scans from a Benewake
+ * TFMini Plus spun on an encoder-driven turret, using the TFMPlus
+ * and TFMPSweep classes of the TFMPlus Library.
+
+ * The TFMPlus object is used only to set the device to 1000Hz.
+ * After that, the TFMPSweep object reads the device serial port
+ * itself.  Do not call 'getData()' on the same port.
+
+ * The encoder is read in an interrupt.  The interrupt only saves
+ * the encoder count and the 'micros()' time.  Then each 'loop()':
+ *   1. 'update()' reads every waiting data frame,
+ *   2. 'addAngle()' passes in the newest encoder reading, and
+ *   3. 'getScan()' passes back each finished revolution once.
+ * 'loop()' must run at least every few milliseconds, so do not use
+ * 'delay()' and keep the work done with each scan short.
+ */
+
+#include <TFMPlus.h>    // Include TFMini Plus Library v1.6.0
+#include <TFMPSweep.h>
+TFMPlus tfmP;           // Create a TFMini Plus object
+TFMPSweep sweep;        // Create a sweep assembler object
+
+#include "printf.h"   // Modified to support Intel based Arduino
+                      // devices such as the Galileo. Download from:
+                      // https://github.com/spaniakos/AES/blob/master/printf.h
+
+// Encoder channel A on an interrupt pin and channel B on any pin.
+// Counts per revolution is for one edge of channel A only.
+#define ENCODER_A          2
+#define ENCODER_B          3
+#define COUNTS_PER_REV   600
+
+// Each scan array holds a little more than one revolution:
+// 1000Hz at 5 revolutions per second is 200 points.
+#define SCAN_SIZE        250
+TFMPScanPoint scanA[ SCAN_SIZE], scanB[ SCAN_SIZE];
+
+// Saved by the interrupt, read by 'loop()'
+volatile int32_t encCount = 0;
+volatile uint32_t encStamp = 0;
+
+// Count one edge of channel A, and save the time it happened.
+void encoderISR()
+{
+    if( digitalRead( ENCODER_B)) encCount--;
+    else encCount++;
+    encStamp = micros();
+}
+
+void setup()
+{
+    Serial.begin( 115200);   // Intialize terminal serial port
+    delay(20);               // Give port time to initalize
+    printf_begin();          // Initialize printf.
+    printf("\r\nTFMPSweep Library Example - 18OCT2026\r\n");  // say 'hello'
+
+    Serial2.begin( 115200);  // Initialize TFMPLus device serial port.
+    delay(20);               // Give port time to initalize
+    tfmP.begin( &Serial2);   // Initialize device library object and...
+                             // pass device serial port to the object.
+
+    // - - Set the data frame-rate to 1000Hz - - - - - - -
+    printf( "Data-Frame rate: ");
+    if( tfmP.sendCommand( SET_FRAME_RATE, FRAME_1000))
+    {
+        printf( "%2uHz.\r\n", FRAME_1000);
+    }
+    else tfmP.printReply();
+
+    // Pass the scan arrays, frame rate and baud rate to the sweep.
+    sweep.begin( scanA, scanB, SCAN_SIZE, FRAME_1000, BAUD_115200);
+
+    pinMode( ENCODER_A, INPUT_PULLUP);
+    pinMode( ENCODER_B, INPUT_PULLUP);
+    attachInterrupt( digitalPinToInterrupt( ENCODER_A), encoderISR, RISING);
+}
+
+uint32_t lastStamp = 0;   // time of the last encoder reading passed in
+
+void loop()
+{
+    // 1. Read every waiting data frame.
+    sweep.update( &Serial2);
+
+    // 2. Copy the newest encoder reading with interrupts held off,
+    //    and pass it in as an angle in hundredths of a degree.
+    noInterrupts();
+    int32_t count = encCount;
+    uint32_t stamp = encStamp;
+    interrupts();
+    if( stamp != lastStamp)
+    {
+        int32_t turn = count % COUNTS_PER_REV;
+        if( turn < 0) turn += COUNTS_PER_REV;
+        sweep.addAngle( ( uint32_t)turn * TFMP_SWEEP_FULL / COUNTS_PER_REV, stamp);
+        lastStamp = stamp;
+    }
+
+    // 3. Use each finished revolution.  Here, find the nearest
+    //    object and print its angle and distance.
+    TFMPScanPoint *scan;
+    uint16_t points;
+    if( sweep.getScan( scan, points))
+    {
+        int16_t nearDist = 0x7FFF;
+        uint16_t nearAngle = 0;
+        for( uint16_t i = 0; i < points; i++)
+        {
+            // Skip points with no return, marked with a negative code.
+            if( scan[ i].dist <= 0 || scan[ i].flux < 0) continue;
+            if( scan[ i].dist < nearDist)
+            {
+                nearDist = scan[ i].dist;
+                nearAngle = scan[ i].angle;
+            }
+        }
+        printf( "Points:%03u ", points);
+        printf( "Nearest:%04icm ", nearDist);
+        printf( "at %03u.%02u deg ", nearAngle / 100, nearAngle % 100);
+        printf( "Dropped:%lu", ( unsigned long)sweep.dropped);
+        printf( "\r\n");
+    }
+}
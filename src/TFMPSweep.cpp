@@ -0,0 +1,346 @@
+/* File Name: TFMPSweep.cpp
+ * Version: 1.6.0
+ * Described: Angle-tagged sweep assembler for the TFMPlus Library.
+ *            Builds 2D scans from a TFMini-Plus that is spun on a
+ *            servo or an encoder-driven turret.
+ * Developer: Bud Ryerson
+ * Inception: v1.6.0 - 18OCT26
+ *
+ * Please see 'TFMPSweep.h' for a description of each function.
+ *
+ * All angle arithmetic is done in hundredths of a degree with
+ * 32 bit integers, so no floating point math is needed.  Time stamps
+ * are 'micros()' values and are only ever subtracted, so the
+ * 70 minute rollover of 'micros()' does no harm.
+ *
+ * 'addAngle()' and 'addSample()' are not interrupt safe.  If the
+ * encoder is read in an interrupt, the interrupt should only save
+ * the angle and 'micros()' time and let 'loop()' pass them in.
+ *
+ */
+
+#include <TFMPSweep.h>
+
+// Constructor
+TFMPSweep::TFMPSweep(){}
+TFMPSweep::~TFMPSweep(){}
+
+// Save the two scan arrays and clear everything else.
+void TFMPSweep::begin( TFMPScanPoint *scanA, TFMPScanPoint *scanB, uint16_t size,
+                       uint16_t rate, uint32_t baud)
+{
+    pScan[ 0] = scanA;
+    pScan[ 1] = scanB;
+    scanSize = size;
+    fillIdx = 0;
+    fillCount = 0;
+    doneCount = 0;
+    doneNew = false;
+    angleHead = 0;
+    angleCount = 0;
+    pendHead = 0;
+    pendCount = 0;
+    lastValid = false;
+    travel = 0;
+    peak = 0;
+    peakIdx = 0;
+    dropped = 0;
+    // A baud rate of zero would divide by zero, so use the default.
+    if( baud == 0) baud = BAUD_115200;
+    // One start bit, eight data bits and one stop bit per byte,
+    // kept in tenths of a microsecond so high baud rates do not drift.
+    byteTenths = 100000000UL / baud;
+    // A frame can not follow the last one more quickly than it can be
+    // sent, and a frame rate of zero means frames are only triggered.
+    framePeriod = ( uint32_t)TFMP_FRAME_SIZE * byteTenths / 10;
+    if( rate > 0 && 1000000UL / rate > framePeriod) framePeriod = 1000000UL / rate;
+    lastPoll = micros();
+    memset( frame, 0, sizeof( frame));
+}
+
+// Hold a sample until an angle event with a later time stamp arrives.
+void TFMPSweep::addSample( int16_t dist, int16_t flux, uint32_t stamp)
+{
+    // If the ring buffer is full, the oldest sample is lost.
+    if( pendCount == TFMP_SWEEP_PENDING)
+    {
+        pendHead = ( pendHead + 1) % TFMP_SWEEP_PENDING;
+        pendCount--;
+        dropped++;
+    }
+    uint8_t i = ( pendHead + pendCount) % TFMP_SWEEP_PENDING;
+    pendDist[ i] = dist;
+    pendFlux[ i] = flux;
+    pendStamp[ i] = stamp;
+    pendCount++;
+
+    // 'update()' backdates each frame, so a later angle event
+    // may already be held.
+    placePending();
+}
+
+// Save a new angle event, then place every waiting sample
+// that arrived before it.
+void TFMPSweep::addAngle( uint16_t angle, uint32_t stamp)
+{
+    angle %= TFMP_SWEEP_FULL;
+
+    if( angleCount > 0)
+    {
+        uint8_t newest = ( angleHead + angleCount - 1) % TFMP_SWEEP_ANGLES;
+        // An event with the same time stamp as the last one corrects it.
+        if( stamp == angleStamp[ newest])
+        {
+            angleRing[ newest] = angle;
+            return;
+        }
+        // An event older than the last one is out of order; ignore it.
+        if( ( int32_t)( stamp - angleStamp[ newest]) < 0) return;
+    }
+
+    // If the ring buffer is full, the oldest event is forgotten.
+    if( angleCount == TFMP_SWEEP_ANGLES)
+    {
+        angleHead = ( angleHead + 1) % TFMP_SWEEP_ANGLES;
+        angleCount--;
+    }
+    uint8_t i = ( angleHead + angleCount) % TFMP_SWEEP_ANGLES;
+    angleRing[ i] = angle;
+    angleStamp[ i] = stamp;
+    angleCount++;
+
+    placePending();
+}
+
+// Place every waiting sample that is no later than the newest
+// angle event, in the order they arrived.
+void TFMPSweep::placePending()
+{
+    if( angleCount == 0) return;
+    uint8_t newest = ( angleHead + angleCount - 1) % TFMP_SWEEP_ANGLES;
+
+    while( pendCount > 0 && ( int32_t)( pendStamp[ pendHead] - angleStamp[ newest]) <= 0)
+    {
+        uint32_t stamp = pendStamp[ pendHead];
+
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Step 1 - Search back from the newest event for the pair
+        //          of events on either side of the sample.
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        uint8_t n = angleCount - 1;
+        uint8_t i1 = newest;
+        uint8_t i0 = newest;
+        bool found = false;
+        while( n > 0)
+        {
+            i0 = ( i1 + TFMP_SWEEP_ANGLES - 1) % TFMP_SWEEP_ANGLES;
+            if( ( int32_t)( stamp - angleStamp[ i0]) >= 0)
+            {
+                found = true;
+                break;
+            }
+            i1 = i0;
+            n--;
+        }
+
+        // A sample older than every event held can not be
+        // interpolated, so it is dropped rather than misplaced.
+        if( !found)
+        {
+            dropped++;
+        }
+        else
+        {
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            // Step 2 - Find the shortest way round from the old angle
+            //          to the new one, in the range -180 to +180 degrees.
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            int32_t delta = ( int32_t)angleRing[ i1] - ( int32_t)angleRing[ i0];
+            if( delta >= TFMP_SWEEP_HALF) delta -= TFMP_SWEEP_FULL;
+            else if( delta < -TFMP_SWEEP_HALF) delta += TFMP_SWEEP_FULL;
+
+            // Scale the time span down to 16 bits so that 'delta' times
+            // the time offset can never overflow a 32 bit integer.
+            uint32_t span = angleStamp[ i1] - angleStamp[ i0];
+            uint32_t offset = stamp - angleStamp[ i0];
+            while( span > 0xFFFF)
+            {
+                span >>= 1;
+                offset >>= 1;
+            }
+
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            // Step 3 - Interpolate and place the sample.
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            int32_t angle = ( int32_t)angleRing[ i0] +
+                            delta * ( int32_t)offset / ( int32_t)span;
+            if( angle >= TFMP_SWEEP_FULL) angle -= TFMP_SWEEP_FULL;
+            else if( angle < 0) angle += TFMP_SWEEP_FULL;
+
+            place( ( uint16_t)angle, pendDist[ pendHead], pendFlux[ pendHead]);
+        }
+
+        pendHead = ( pendHead + 1) % TFMP_SWEEP_PENDING;
+        pendCount--;
+    }
+}
+
+// Publish the array being filled as the finished scan, keeping its
+// first 'keep' points, and start filling the other array.
+void TFMPSweep::finishScan( uint16_t keep)
+{
+    doneCount = keep;
+    doneNew = true;
+    fillIdx ^= 1;
+    fillCount = 0;
+}
+
+// Store one point in the array being filled.  First, finish the scan
+// if the angle has crossed zero after more than half a turn of travel,
+// or if the angle has turned back by more than 'TFMP_SWEEP_REVERSE'.
+void TFMPSweep::place( uint16_t angle, int16_t dist, int16_t flux)
+{
+    if( lastValid)
+    {
+        int32_t diff = ( int32_t)angle - ( int32_t)lastAngle;
+        if( diff >= TFMP_SWEEP_HALF) diff -= TFMP_SWEEP_FULL;
+        else if( diff < -TFMP_SWEEP_HALF) diff += TFMP_SWEEP_FULL;
+        int32_t unwrapped = ( int32_t)lastAngle + diff;
+        travel += diff;
+
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Continuous turn - A blip back and forth across zero adds
+        // little travel, so it is kept in the scan being filled.
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        if( ( unwrapped >= TFMP_SWEEP_FULL || unwrapped < 0) &&
+            ( travel > TFMP_SWEEP_HALF || travel < -TFMP_SWEEP_HALF))
+        {
+            finishScan( fillCount);
+            travel = 0;
+            peak = 0;
+        }
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Back and forth sweep - Follow the furthest travel in the
+        // present direction.  Once the angle has turned back from it
+        // by more than 'TFMP_SWEEP_REVERSE', end the scan at that
+        // furthest point and carry the points after it over to the
+        // next scan.
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        else if( ( peak >= 0 && travel >= peak) || ( peak <= 0 && travel <= peak))
+        {
+            peak = travel;
+            peakIdx = fillCount;
+        }
+        else if( peak > TFMP_SWEEP_REVERSE || peak < -TFMP_SWEEP_REVERSE)
+        {
+            int32_t back = peak - travel;
+            if( back > TFMP_SWEEP_REVERSE || back < -TFMP_SWEEP_REVERSE)
+            {
+                uint16_t keep = peakIdx + 1;
+                if( keep > fillCount) keep = fillCount;
+                TFMPScanPoint *last = pScan[ fillIdx];
+                uint16_t carry = fillCount - keep;
+                finishScan( keep);
+                for( uint16_t k = 0; k < carry; k++)
+                {
+                    pScan[ fillIdx][ k] = last[ keep + k];
+                }
+                fillCount = carry;
+                travel -= peak;
+                peak = travel;
+                peakIdx = fillCount;
+            }
+        }
+    }
+    lastAngle = angle;
+    lastValid = true;
+
+    // If the scan array is full, drop the point.
+    if( fillCount >= scanSize)
+    {
+        dropped++;
+        return;
+    }
+    TFMPScanPoint &point = pScan[ fillIdx][ fillCount++];
+    point.angle = angle;
+    point.dist = dist;
+    point.flux = flux;
+}
+
+// Read every byte waiting in the serial buffer without blocking.
+// Pass each data frame with a good checksum to 'addSample()', stamped
+// with the time its header byte began to arrive.  Return TRUE if any
+// were passed.
+bool TFMPSweep::update( Stream *streamPtr)
+{
+    // Every byte read now arrived since the last call.
+    uint32_t now = micros();
+    uint32_t since = now - lastPoll;
+    lastPoll = now;
+
+    uint32_t sendTime = ( uint32_t)TFMP_FRAME_SIZE * byteTenths / 10;
+    bool added = false;
+    while( (*streamPtr).available())
+    {
+        // Read one byte into the last plus one position
+        // and shift the whole frame buffer one byte left.
+        frame[ TFMP_FRAME_SIZE] = (*streamPtr).read();
+        memmove( frame, frame + 1, TFMP_FRAME_SIZE);
+
+        // Go on reading until the two HEADER bytes are first.
+        if( ( frame[ 0] != 0x59) || ( frame[ 1] != 0x59)) continue;
+
+        // Go on reading if the checksum does not match.  If this is a
+        // real frame that was damaged, the next header will resync.
+        uint8_t sum = 0;
+        for( uint8_t i = 0; i < ( TFMP_FRAME_SIZE - 1); i++) sum += frame[ i];
+        if( sum != frame[ TFMP_FRAME_SIZE - 1]) continue;
+
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Work back to the time this frame's header began to arrive
+        // from the whole and partial frames still queued behind it.
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        uint16_t queued = (*streamPtr).available();
+        uint16_t whole = queued / TFMP_FRAME_SIZE;
+        uint16_t part = queued % TFMP_FRAME_SIZE;
+        uint32_t stamp;
+        if( part > 0)
+        {
+            // The partial frame is still arriving, so its header
+            // began 'part' bytes ago.
+            stamp = now - ( uint32_t)part * byteTenths / 10
+                        - ( uint32_t)( whole + 1) * framePeriod;
+        }
+        else
+        {
+            // The newest whole frame ended at some time since the last
+            // call, and within one frame period, so take the middle.
+            uint32_t wait = framePeriod - sendTime;
+            if( since < wait) wait = since;
+            stamp = now - wait / 2 - sendTime
+                        - ( uint32_t)whole * framePeriod;
+        }
+
+        int16_t dist = frame[ 2] + ( frame[ 3] << 8);
+        int16_t flux = frame[ 4] + ( frame[ 5] << 8);
+
+        // Clear the buffer so no part of this frame is read again.
+        memset( frame, 0, sizeof( frame));
+
+        // Abnormal data is kept with its codes so that angles with
+        // no return are marked in the scan rather than left out.
+        addSample( dist, flux, stamp);
+        added = true;
+    }
+    return added;
+}
+
+// Pass back the finished scan only once.
+bool TFMPSweep::getScan( TFMPScanPoint *&scan, uint16_t &count)
+{
+    if( !doneNew) return false;
+    scan = pScan[ fillIdx ^ 1];
+    count = doneCount;
+    doneNew = false;
+    return true;
+}
@@ -0,0 +1,181 @@
+/* File Name: TFMPSweep.h
+ * Version: 1.6.0
+ * Described: Angle-tagged sweep assembler for the TFMPlus Library.
+ *            Builds 2D scans from a TFMini-Plus that is spun on a
+ *            servo or an encoder-driven turret.
+ * Developer: Bud Ryerson
+ * Inception: v1.6.0 - 18OCT26
+ *
+ * The application passes in two scan arrays of its own.  No heap
+ * is used and scan data is not copied, apart from the few points
+ * after the turn of a back and forth sweep.  One array is filled
+ * while the other holds the last finished revolution or sweep.
+ *
+ * 'begin( scanA, scanB, size, rate, baud)' passes two preallocated
+ *  arrays of 'TFMPScanPoint', the number of points each array can
+ *  hold, and the frame rate (default 100Hz) and serial baud rate
+ *  (default 115200) the device is set to.  A baud rate of zero is
+ *  taken as the default.
+ *
+ * 'addAngle( angle, stamp)' passes an angle event from the encoder
+ *  or servo.  'angle' is in hundredths of a degree (0 - 35999) and
+ *  'stamp' is the 'micros()' time at which that angle was reached.
+ *  An event with the same stamp as the last one replaces its angle;
+ *  an event with an older stamp is ignored.
+ *
+ * 'addSample( dist, flux, stamp)' passes one measurement and the
+ *  'micros()' time at which it arrived.  Samples are held until an
+ *  angle event with a later time stamp arrives, then each sample is
+ *  given an angle by linear interpolation between the two angle
+ *  events on either side of it.  The last 'TFMP_SWEEP_ANGLES' events
+ *  (default 32) are kept for this, so a sample can be placed even
+ *  when several events arrived after it.  A sample older than every
+ *  event held is dropped.
+ *
+ * 'update( streamPtr)' reads every byte waiting in the device serial
+ *  stream without blocking, and passes each complete data frame to
+ *  'addSample()'.  Abnormal frames that 'getData()' would reject are
+ *  kept with their codes, so angles with no return (open sky or out
+ *  of range) show up in the scan as points with 'dist' of -1 or -4,
+ *  or 'flux' of -1.  Unlike 'getData()' it does not flush the buffer,
+ *  so no frame is skipped.  Each frame is stamped with the time its
+ *  header byte began to arrive.  Because the device sends frames
+ *  steadily at the set frame rate, that time is worked back from the
+ *  number of bytes still queued behind the frame, the frame period
+ *  and the byte transfer time.  When no part of a later frame is
+ *  queued, the newest frame ended some time since the last call to
+ *  'update()', and the middle of that time is used.  So the more
+ *  often 'update()' is called, the closer the stamp.  'update()' must be
+ *  called often enough that the serial buffer does not overflow;
+ *  a 64 byte buffer holds only seven frames, or 7ms at 1000Hz.
+ *  Do not also call 'getData()' on the same stream.
+ *
+ * 'getScan( scan, count)' returns TRUE if a new revolution or sweep
+ *  has finished since the last call, and passes back a pointer to it
+ *  and the number of points in it.  The scan remains valid until
+ *  the next one finishes.
+ *
+ * A scan is finished in one of two ways.  On a continuous turret, a
+ * revolution is finished when the interpolated angle crosses zero in
+ * either direction, but only after more than half a turn of travel
+ * since the last scan finished.  On a servo that sweeps back and
+ * forth, a sweep is finished when the angle turns back by more than
+ * 'TFMP_SWEEP_REVERSE' (default 5 degrees) from the furthest point
+ * reached.  The scan ends at that furthest point, and the few points
+ * after it are carried over to start the next scan.  So encoder noise
+ * at the index, or a servo hunting about a point, does not finish
+ * a scan early or overwrite the one last passed back.
+ *
+ * Angle events must arrive often enough for two reasons.  Events more
+ * than half a turn apart cannot be told apart from a reversal.  And
+ * samples wait for the next event in a ring of 'TFMP_SWEEP_PENDING'
+ * places (default 32), so at 1000Hz events must be less than 32ms
+ * apart or the oldest samples are dropped.  The ring can be enlarged
+ * with a compiler flag such as -DTFMP_SWEEP_PENDING=128, up to 255.
+ *
+ * Angle events may also arrive much faster than frames do.  Because
+ * 'update()' backdates each frame by at least its own transfer time,
+ * the events held must reach back at least that far, and further if
+ * frames queue up between calls.  With events every 200us and
+ * 'update()' called every millisecond, 32 events reach back 6.4ms.
+ * 'TFMP_SWEEP_ANGLES' can be raised the same way, up to 255.
+ *
+ */
+
+#ifndef TFMPSWEEP_H     // Guard to compile only once
+#define TFMPSWEEP_H
+
+#include <Arduino.h>
+#include <TFMPlus.h>
+
+#define TFMP_SWEEP_FULL      36000   // One turn in hundredths of a degree
+#define TFMP_SWEEP_HALF      18000
+#ifndef TFMP_SWEEP_PENDING
+#define TFMP_SWEEP_PENDING      32   // Samples held waiting for an angle
+#endif
+#if TFMP_SWEEP_PENDING > 255
+#error "TFMP_SWEEP_PENDING must be 255 or less"
+#endif
+#ifndef TFMP_SWEEP_REVERSE
+#define TFMP_SWEEP_REVERSE     500   // Turn back that ends a sweep (5 deg)
+#endif
+#ifndef TFMP_SWEEP_ANGLES
+#define TFMP_SWEEP_ANGLES       32   // Recent angle events held
+#endif
+#if TFMP_SWEEP_ANGLES < 2 || TFMP_SWEEP_ANGLES > 255
+#error "TFMP_SWEEP_ANGLES must be from 2 to 255"
+#endif
+
+// One point in a scan
+struct TFMPScanPoint
+{
+    uint16_t angle;        // hundredths of a degree, 0 - 35999
+    int16_t dist;          // distance, or -1 weak signal, -4 ambient light
+    int16_t flux;          // signal strength, or -1 signal saturation
+};
+
+// Object Class Definitions
+class TFMPSweep
+{
+  public:
+    TFMPSweep();
+    ~TFMPSweep();
+
+    uint32_t dropped;      // count of samples that could not be placed
+
+    // Pass two scan arrays of 'size' points each, and reset.
+    void begin( TFMPScanPoint *scanA, TFMPScanPoint *scanB, uint16_t size,
+                uint16_t rate = FRAME_100, uint32_t baud = BAUD_115200);
+    // Pass an angle event and place any samples waiting for it.
+    void addAngle( uint16_t angle, uint32_t stamp);
+    // Pass a measurement to be placed at its interpolated angle.
+    void addSample( int16_t dist, int16_t flux, uint32_t stamp);
+    // Read all waiting frames and pass each one to 'addSample()'.
+    bool update( Stream *streamPtr);
+    // Pass back the last finished revolution if it is new.
+    bool getScan( TFMPScanPoint *&scan, uint16_t &count);
+
+  private:
+    TFMPScanPoint* pScan[ 2];   // the two scan arrays
+    uint16_t scanSize;          // points in each scan array
+    uint8_t fillIdx;            // index of the array being filled
+    uint16_t fillCount;         // points in the array being filled
+    uint16_t doneCount;         // points in the finished array
+    bool doneNew;               // finished array not yet passed back
+
+    // Recent angle events, as a ring buffer, so that a backdated
+    // sample can still be placed between the two events around it.
+    uint16_t angleRing[ TFMP_SWEEP_ANGLES];
+    uint32_t angleStamp[ TFMP_SWEEP_ANGLES];
+    uint8_t angleHead;          // oldest event held
+    uint8_t angleCount;         // number of events held
+
+    // Samples waiting for a later angle event, as a ring buffer.
+    int16_t pendDist[ TFMP_SWEEP_PENDING];
+    int16_t pendFlux[ TFMP_SWEEP_PENDING];
+    uint32_t pendStamp[ TFMP_SWEEP_PENDING];
+    uint8_t pendHead;           // oldest waiting sample
+    uint8_t pendCount;          // number of waiting samples
+
+    // Frame reader used by 'update()'.  As in 'TFMPlus', the buffer
+    // is one byte longer than a frame so it can be shifted left.
+    uint8_t frame[ TFMP_FRAME_SIZE + 1];
+    uint32_t byteTenths;        // tenths of a microsecond per serial byte
+    uint32_t framePeriod;       // microseconds from one frame to the next
+    uint32_t lastPoll;          // 'micros()' time of the last 'update()'
+
+    uint16_t lastAngle;         // angle of the last point placed
+    int32_t travel;             // signed travel since the last scan ended
+    int32_t peak;               // furthest travel in the present direction
+    uint16_t peakIdx;           // index of the point at 'peak'
+    bool lastValid;             // a point has been placed this scan
+
+    // Interpolate and place every sample the events now cover.
+    void placePending();
+    // Publish the array being filled and start on the other one.
+    void finishScan( uint16_t keep);
+    // Store one point, finishing the scan first if it is complete.
+    void place( uint16_t angle, int16_t dist, int16_t flux);
+};
+
+#endif
@@ -1,5 +1,5 @@
 /* File Name: TFMPlus.h
- * Version: 1.5.0
+ * Version: 1.6.0
  * Described: Arduino Library for the Benewake TFMini-Plus Lidar sensor
  *            The TFMini-Plus is a unique product, and the various
  *            TFMini Libraries are not compatible with the Plus.
@@ -49,6 +49,8 @@
                OBTAIN_FIRMWARE_VERSION is now GET_FIRMWARE_VERSION
                RESTORE_FACTORY_SETTINGS is now HARD_RESET
                SYSTEM_RESET is now SOFT_RESET
+ * v.1.6.0 - 18OCT26 - Added 'TFMPSweep' class in 'TFMPSweep.h' to build
+             angle-tagged 2D scans from a rotating device.
  *
  * Default settings for the TFMini-Plus are a 115200 serial baud rate
  * and a 100Hz measurement frame rate. The device will begin returning